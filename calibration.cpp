@@ -1,15 +1,10 @@
 #include "calibration.h"
 
-Calibration::Calibration() {
-	std::string windowName = "Calibration";
-	
+Calibration::Calibration(cv::Scalar targetRGB, int tolerance)
+    : detector(targetRGB, tolerance) {
 	worldPoints = {
         {0, 140}, {0, 100}, {0, 60}, {0, 20}, {40, 100}, {-40, 100}, {10, 20}, {-10, 20}
     };
-    
-	cv::namedWindow(windowName);
-	cv::setMouseCallback(windowName, onMouse, this);
-
 }
 
 bool Calibration::getCalibrationDone() {
@@ -19,6 +14,19 @@ bool Calibration::getCalibrationDone() {
 bool Calibration::handleFrame(const cv::Mat& frame) {
     if (calibrationDone) return true;
 
+    if (automatic) {
+		return handleFrameAutomatic(frame);
+	}
+	return handleFrameManual(frame);
+}
+
+bool Calibration::handleFrameManual(const cv::Mat& frame) {
+	if (!windowCreated) {
+		cv::namedWindow(windowName);
+		cv::setMouseCallback(windowName, onMouse, this);
+		windowCreated = true;
+	}
+
     cv::cvtColor(frame, currentFrame, cv::COLOR_RGB2BGR); // Fix problem with libcamera2opencv formatting
     
 	std::string msg = "Place @ x=";
@@ -68,6 +76,78 @@ bool Calibration::handleFrame(const cv::Mat& frame) {
     return calibrationDone;
 }
 
+bool Calibration::handleFrameAutomatic(const cv::Mat& frame) {
+	if (autoPositions.empty()) {
+		autoPositions = getGridWorldPoints(autoGridStep);
+		promptPosition();
+	}
+
+	// Nothing is sampled until the operator confirms the dot is on the prompted position
+	if (awaitingConfirmation) {
+		pixelBuffer.clear();
+		return false;
+	}
+
+	cv::Point pixel = detector.detect(frame);
+	pixelBuffer.add(cv::Point2f(pixel.x, pixel.y));
+
+	if (!pixelBuffer.allWithinTolerance()) {
+		return false;
+	}
+
+	// Wait until the dot has been moved away from the previous position
+	if (positionSamples == 0 && lastPositionPixel.x != -1 && cv::norm(pixelBuffer.getAverage() - lastPositionPixel) < minPixelMove) {
+		return false;
+	}
+
+	sampleImagePoints.push_back(cv::Point2f(pixel.x, pixel.y));
+	sampleWorldPoints.push_back(autoPositions[positionIndex]);
+	positionSamples++;
+
+	if (positionSamples < samplesPerPosition) {
+		return false;
+	}
+
+	lastPositionPixel = pixelBuffer.getAverage();
+	positionSamples = 0;
+	positionIndex++;
+	std::cout << "Sampled position " << positionIndex << "/" << autoPositions.size() << " at pixel " << lastPositionPixel << std::endl;
+
+	if (positionIndex < autoPositions.size()) {
+		promptPosition();
+		return false;
+	}
+
+	cv::cvtColor(frame, currentFrame, cv::COLOR_RGB2BGR); // Fix problem with libcamera2opencv formatting
+	computeHomographyFromSamples();
+
+	return calibrationDone;
+}
+
+void Calibration::promptPosition() {
+	const cv::Point2f& position = autoPositions[positionIndex];
+	std::cout << "Place @ x=" << static_cast<int>(position.x) << "cm, y=" << static_cast<int>(position.y) << "cm and press Enter" << std::endl;
+	awaitingConfirmation = true;
+}
+
+bool Calibration::getAwaitingConfirmation() {
+	return awaitingConfirmation;
+}
+
+void Calibration::confirmPosition() {
+	awaitingConfirmation = false;
+}
+
+void Calibration::restartSampling() {
+	sampleImagePoints.clear();
+	sampleWorldPoints.clear();
+	positionIndex = 0;
+	positionSamples = 0;
+	// lastPositionPixel is kept, the dot still resting on the last position must not be sampled as the first one
+	pixelBuffer.clear();
+	promptPosition();
+}
+
 void Calibration::onMouse(int event, int x, int y, int, void* userdata) {
     if (event != cv::EVENT_LBUTTONDOWN) return;
 
@@ -94,6 +174,32 @@ void Calibration::onMouse(int event, int x, int y, int, void* userdata) {
 
 void Calibration::computeHomography() {	
     homography = cv::findHomography(getHomographyFormatFromPoints(imagePoints), getHomographyFormatFromPoints(worldPoints));
+    saveHomography();
+}
+
+void Calibration::computeHomographyFromSamples() {
+	// Fit once over all samples, RANSAC drops detections taken while the dot was being moved
+	std::vector<uchar> inlierMask;
+	homography = cv::findHomography(sampleImagePoints, sampleWorldPoints, cv::RANSAC, ransacThreshold, inlierMask);
+
+	if (homography.empty()) {
+		std::cerr << "Failed to fit homography, restarting sampling." << std::endl;
+		restartSampling();
+		return;
+	}
+
+	std::cout << "RANSAC inliers: " << cv::countNonZero(inlierMask) << "/" << sampleImagePoints.size() << std::endl;
+	if (!checkReprojectionError(inlierMask)) {
+		// Keep the existing homography.yaml rather than replacing it with a poor fit
+		std::cerr << "Calibration rejected, homography not saved. Restarting sampling." << std::endl;
+		homography.release();
+		restartSampling();
+		return;
+	}
+	saveHomography();
+}
+
+void Calibration::saveHomography() {
     cv::FileStorage fs("homography.yaml", cv::FileStorage::WRITE);
     fs << "homography" << homography;
     fs.release();
@@ -105,7 +211,70 @@ void Calibration::computeHomography() {
     cv::Mat frameWithGrid = addGridToImage(currentFrame);
     cv::imwrite("calibration_grid.jpg", frameWithGrid);
     
-    cv::destroyWindow(windowName);
+    if (windowCreated) {
+		cv::destroyWindow(windowName);
+	}
+}
+
+bool Calibration::checkReprojectionError(const std::vector<uchar>& inlierMask) {
+	std::vector<cv::Point2f> projected;
+	cv::perspectiveTransform(sampleImagePoints, projected, homography);
+
+	double sumSquared = 0.0;
+	double maxError = 0.0;
+	int totalInliers = 0;
+	bool positionsValid = true;
+
+	// Error is reported over RANSAC inliers only, rejected samples are counted per grid point
+	for (const auto& position : autoPositions) {
+		double positionSum = 0.0;
+		int samples = 0;
+		int inliers = 0;
+		for (size_t i = 0; i < projected.size(); ++i) {
+			if (sampleWorldPoints[i] != position) continue;
+			samples++;
+			if (!inlierMask[i]) continue;
+			double error = cv::norm(projected[i] - position);
+			positionSum += error;
+			sumSquared += error * error;
+			maxError = std::max(maxError, error);
+			inliers++;
+		}
+		totalInliers += inliers;
+
+		std::cout << "Grid point " << position << ": " << inliers << "/" << samples << " inliers";
+		if (inliers > 0) {
+			std::cout << ", mean error " << positionSum / inliers << "cm";
+		}
+		if (inliers < minPositionInlierFraction * samples) {
+			std::cout << " REJECTED";
+			positionsValid = false;
+		}
+		std::cout << std::endl;
+	}
+
+	if (totalInliers == 0) {
+		std::cerr << "No inliers." << std::endl;
+		return false;
+	}
+
+	double rms = std::sqrt(sumSquared / totalInliers);
+	double inlierFraction = static_cast<double>(totalInliers) / projected.size();
+	std::cout << "Reprojection error over inliers RMS: " << rms << "cm, max: " << maxError << "cm" << std::endl;
+
+	if (!positionsValid) {
+		std::cerr << "Too many samples rejected at some grid points." << std::endl;
+		return false;
+	}
+	if (inlierFraction < minInlierFraction) {
+		std::cerr << "Inlier fraction " << inlierFraction << " below " << minInlierFraction << "." << std::endl;
+		return false;
+	}
+	if (rms > maxRmsError) {
+		std::cerr << "RMS error " << rms << "cm above " << maxRmsError << "cm." << std::endl;
+		return false;
+	}
+	return true;
 }
 
 bool Calibration::loadHomography() {
@@ -131,14 +300,24 @@ cv::Mat Calibration::getHomographyFormatFromPoints(std::vector<cv::Point2f> poin
 	return homographyMat;
 }
 
+std::vector<cv::Point2f> Calibration::getGridWorldPoints(int step) {
+	std::vector<cv::Point2f> points;
+	for (int y = gridYMin; y <= gridYMax; y += step) {
+		for (int x = gridXMin; x <= gridXMax; x += step) {
+			points.push_back(cv::Point2f(x, y));
+		}
+	}
+	return points;
+}
+
 cv::Mat Calibration::addGridToImage(const cv::Mat& inputImage) {
     cv::Mat image = inputImage.clone();
 
     cv::Mat H_inv = homography.inv();
 
     std::vector<int> x_range, y_range;
-    for (int x = -40; x <= 40; x += 10) x_range.push_back(x);
-    for (int y = 20; y <= 100; y += 10) y_range.push_back(y);
+    for (int x = gridXMin; x <= gridXMax; x += gridStep) x_range.push_back(x);
+    for (int y = gridYMin; y <= gridYMax; y += gridStep) y_range.push_back(y);
 
     for (int x : x_range) {
         for (int y : y_range) {
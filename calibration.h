@@ -3,20 +3,34 @@
 
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
+#include <atomic>
+#include "tracking.h"
 
 class Calibration {
 	public:
-		Calibration();
+		Calibration(cv::Scalar targetRGB = cv::Scalar(255, 0, 0), int tolerance = 70);
 		bool handleFrame(const cv::Mat& frame); // called by the camera callback
 		bool loadHomography();
 		const cv::Mat& getHomography() const;
 		bool getCalibrationDone();
-		
+		bool getAwaitingConfirmation(); // automatic mode waits for the operator to place the dot
+		void confirmPosition();
+		bool automatic = false; // detect the laser dot instead of waiting for mouse clicks, runs headless
+		int samplesPerPosition = 20;
+
 
 	private:
+		bool handleFrameManual(const cv::Mat& frame);
+		bool handleFrameAutomatic(const cv::Mat& frame);
 		void computeHomography();
+		void computeHomographyFromSamples();
+		void promptPosition();
+		void restartSampling();
+		void saveHomography();
+		bool checkReprojectionError(const std::vector<uchar>& inlierMask);
 		static void onMouse(int event, int x, int y, int, void* userdata);
 		cv::Mat getHomographyFormatFromPoints(std::vector<cv::Point2f> points);
+		std::vector<cv::Point2f> getGridWorldPoints(int step);
 		cv::Mat addGridToImage(const cv::Mat& inputImage);
 
 		std::vector<cv::Point2f> imagePoints;
@@ -24,8 +38,30 @@ class Calibration {
 		cv::Mat currentFrame;
 		cv::Mat homography;
 		bool calibrationDone = false;
+		bool windowCreated = false;
 		std::string windowName = "Calibration";
 		float scaleFactor = 0.5;
+
+		// Grid drawn by addGridToImage in cm, automatic mode samples every second grid point of it
+		int gridXMin = -40, gridXMax = 40;
+		int gridYMin = 20, gridYMax = 100;
+		int gridStep = 10;
+		int autoGridStep = 20;
+
+		LaserDetector detector;
+		PointRingBuffer pixelBuffer;
+		std::vector<cv::Point2f> autoPositions;
+		std::vector<cv::Point2f> sampleImagePoints;
+		std::vector<cv::Point2f> sampleWorldPoints;
+		std::atomic<bool> awaitingConfirmation{false};
+		size_t positionIndex = 0;
+		int positionSamples = 0;
+		cv::Point2f lastPositionPixel = cv::Point2f(-1.0f, -1.0f);
+		float minPixelMove = 50.0f; // dot has to move this far before the next position is sampled
+		double ransacThreshold = 1.0; // cm
+		double minInlierFraction = 0.8; // of all samples
+		double minPositionInlierFraction = 0.5; // of the samples of each grid point
+		double maxRmsError = 0.5; // cm
 };
 
 
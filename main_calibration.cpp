@@ -1,11 +1,17 @@
 #include "calibration.h"
 #include <iostream>
 #include <libcam2opencv.h>
+#include <string>
 
-Libcam2OpenCVSettings getCalibrationCameraSettings() {
+Libcam2OpenCVSettings getCalibrationCameraSettings(bool automatic) {
     Libcam2OpenCVSettings settings;
     settings.width = 4608 / 2;
     settings.height = 2592 / 2;
+    if (automatic) {
+        // Same tuning as tracking so the laser dot is detected reliably
+        settings.saturation = 3.0;
+        settings.brightness = -0.25;
+    }
     return settings;
 }
 
@@ -24,14 +30,27 @@ Libcam2OpenCV calibrationCamera;
 CalibrationCameraCallback calibrationCameraCallback;
 
 
-int main() {
+int main(int argc, char* argv[]) {
     std::cout << "Start Calibration" << std::endl;
     
+    for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--auto") {
+			calibration.automatic = true;
+		}
+	}
+    
 	calibrationCameraCallback.calibration = &calibration;
 	calibrationCamera.registerCallback(&calibrationCameraCallback);
-	calibrationCamera.start(getCalibrationCameraSettings());
+	calibrationCamera.start(getCalibrationCameraSettings(calibration.automatic));
     
-	while(!calibration.getCalibrationDone()) {}
+	while(!calibration.getCalibrationDone()) {
+		if (calibration.getAwaitingConfirmation()) {
+			std::string line;
+			std::getline(std::cin, line);
+			calibration.confirmPosition();
+		}
+	}
 	
 	calibrationCamera.stop();
     
@@ -60,8 +60,16 @@ bool PointRingBuffer::allWithinTolerance(float tolerance_x, float tolerance_y) {
 	return true;
 }
 
+void PointRingBuffer::clear() {
+	for (int i = 0; i < bufferLength; ++i) {
+		buffer[i] = cv::Point2f(-1.0f, -1.0f);
+	}
+	index = 0;
+	size = 0;
+}
+
 Tracking::Tracking(cv::Scalar targetRGB, int tolerance)
-    : targetRGB(targetRGB), tolerance(tolerance) {
+    : detector(targetRGB, tolerance) {
 		if (!loadHomography()) {
 			std::cout << "An error reading homography.yaml has occurred" << std::endl;
 		}
@@ -75,14 +83,7 @@ bool Tracking::handleFrame(const cv::Mat& frame) {
 		return true;
 	}
 	
-	currentFrame = frame.clone();
-
-    currentFrame = markColor(currentFrame);
-    currentFrame = closeGaps(currentFrame);
-    currentFrame = filterRoundClustersByShape(currentFrame);
-    currentFrame = keepLargestFeature(currentFrame);
-   
-    cv::Point center = findCenter(currentFrame);
+    cv::Point center = detector.detect(frame);
     cv::Point realWorldCenter = pixelCoord2WorldCoord(center);
     
     ringBuffer.add(realWorldCenter);
@@ -106,8 +107,20 @@ bool Tracking::handleFrame(const cv::Mat& frame) {
     return getTrackingDone();
 }
 
+LaserDetector::LaserDetector(cv::Scalar targetRGB, int tolerance)
+    : targetRGB(targetRGB), tolerance(tolerance) {
+}
+
+cv::Point LaserDetector::detect(const cv::Mat& frame) {
+	cv::Mat mask = markColor(frame);
+    mask = closeGaps(mask);
+    mask = filterRoundClustersByShape(mask);
+    mask = keepLargestFeature(mask);
+   
+    return findCenter(mask);
+}
 
-cv::Mat Tracking::markColor(const cv::Mat& image) {	
+cv::Mat LaserDetector::markColor(const cv::Mat& image) {	
 	cv::Scalar lowerBound(
 		std::max(0.0, targetRGB[0] - tolerance),
 		std::max(0.0, targetRGB[1] - tolerance),
@@ -126,7 +139,7 @@ cv::Mat Tracking::markColor(const cv::Mat& image) {
 	return mask;
 }
 
-cv::Mat Tracking::closeGaps(const cv::Mat& binaryMask, int kernel_size) {
+cv::Mat LaserDetector::closeGaps(const cv::Mat& binaryMask, int kernel_size) {
 	cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(kernel_size, kernel_size));
 
 	cv::Mat mask = binaryMask.clone();
@@ -138,7 +151,7 @@ cv::Mat Tracking::closeGaps(const cv::Mat& binaryMask, int kernel_size) {
 }
 
 
-cv::Mat Tracking::filterRoundClustersByShape(const cv::Mat& binaryMask, std::pair<double, double> aspectRatioRange){
+cv::Mat LaserDetector::filterRoundClustersByShape(const cv::Mat& binaryMask, std::pair<double, double> aspectRatioRange){
 	cv::Mat labels, stats, centroids;
 	int numLabels = cv::connectedComponentsWithStats(binaryMask, labels, stats, centroids, 8);
 
@@ -162,7 +175,7 @@ cv::Mat Tracking::filterRoundClustersByShape(const cv::Mat& binaryMask, std::pai
 }
 
 
-cv::Mat Tracking::keepLargestFeature(const cv::Mat& binary_mask) {
+cv::Mat LaserDetector::keepLargestFeature(const cv::Mat& binary_mask) {
 	cv::Mat labels, stats, centroids;
 	int num_labels = cv::connectedComponentsWithStats(binary_mask, labels, stats, centroids, 8, CV_32S);
 
@@ -187,7 +200,7 @@ cv::Mat Tracking::keepLargestFeature(const cv::Mat& binary_mask) {
 	return largest_mask;
 }
 
-cv::Point Tracking::findCenter(const cv::Mat& mask) {
+cv::Point LaserDetector::findCenter(const cv::Mat& mask) {
 	if (mask.empty()) {
 		std::cerr << "Error: Input mask is empty." << std::endl;
 		return cv::Point(-1, -1);
@@ -20,6 +20,23 @@ public:
 	cv::Point2f get(int i);
 	bool allWithinTolerance(float tolerance_x = 15, float tolerance_y = 15);
 	cv::Point2f getAverage();
+	void clear();
+};
+
+class LaserDetector {
+	public:
+		LaserDetector(cv::Scalar targetRGB, int tolerance);
+		cv::Point detect(const cv::Mat& frame); // pixel location of the laser dot, (-1, -1) if none
+
+	private:
+		cv::Scalar targetRGB;
+		int tolerance;
+
+		cv::Mat markColor(const cv::Mat& image);
+		cv::Mat closeGaps(const cv::Mat& binary_mask, int kernel_size = 5);
+		cv::Mat filterRoundClustersByShape(const cv::Mat& binaryMask, std::pair<double, double> aspectRatioRange = {0.5, 2.33});
+		cv::Mat keepLargestFeature(const cv::Mat& binary_mask);
+		cv::Point findCenter(const cv::Mat& mask);
 };
 
 class Tracking {
@@ -31,20 +48,13 @@ class Tracking {
 		bool debug = false;
 
 	private:
-		cv::Scalar targetRGB;
-		int tolerance;
+		LaserDetector detector;
 		cv::Mat homography;
-		cv::Mat currentFrame;
 		PointRingBuffer ringBuffer;	
 		bool trackingDone = false;	
 		
 		
 		bool loadHomography();
-		cv::Mat markColor(const cv::Mat& image);
-		cv::Mat closeGaps(const cv::Mat& binary_mask, int kernel_size = 5);
-		cv::Mat filterRoundClustersByShape(const cv::Mat& binaryMask, std::pair<double, double> aspectRatioRange = {0.5, 2.33});
-		cv::Mat keepLargestFeature(const cv::Mat& binary_mask);
-		cv::Point findCenter(const cv::Mat& mask);
 		cv::Point2f pixelCoord2WorldCoord(const cv::Point pixelCoord);
 		void showImage(const cv::Mat& image, const cv::Point& center = cv::Point(-1, -1));
 };